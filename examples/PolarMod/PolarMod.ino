@@ -0,0 +1,27 @@
+#include <G1OJS_Tiny_Si5351_CLK0.h>
+
+#include <Wire.h>
+#include "Arduino.h"
+
+// Sends a slow 1 kHz-deviation FSK tone on 145 MHz with the drive level ramping up and down,
+// using the polar-modulation engine (one polar_sample call per sample period)
+
+G1OJS_Tiny_Si5351_CLK0 DDS;
+
+void setup()
+{
+  Wire.begin();
+  Wire.setClock(400000);
+  delay(1000);
+  DDS.polar_begin((uint32_t)145000000);
+}
+
+
+void loop() {
+  for (uint16_t i = 0; i < 512; i++) {
+    uint8_t amplitude = (i < 256) ? i : 511 - i;
+    int32_t fdev_Hz = (i & 0x40) ? 1000 : -1000;
+    DDS.polar_sample(amplitude, fdev_Hz);
+    delay(5);
+  }
+}
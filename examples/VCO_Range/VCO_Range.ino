@@ -0,0 +1,36 @@
+#include <G1OJS_Tiny_Si5351_CLK0.h>
+
+#include <Wire.h>
+#include "Arduino.h"
+
+// Measures this Si5351's VCO lock range and lets set_freq_Hz use it. Starting from 120 MHz on /6,
+// the retune to 98 MHz puts the VCO at 588 MHz, just below the nominal 600 MHz; if this chip
+// locks there it stays on /6 and only the Feedback Multisynth is updated, with no PLL reset.
+// On AVR the range is kept in EEPROM (5 bytes at vco_range_addr) so later runs just load it.
+
+#define vco_range_addr 0
+
+void setup()
+{
+  Wire.begin();
+  delay(1000);
+  G1OJS_Tiny_Si5351_CLK0 DDS;
+#if defined(ARDUINO_ARCH_AVR)
+  if (!DDS.load_vco_range(vco_range_addr)) {
+    if (DDS.characterise_vco()) DDS.store_vco_range(vco_range_addr);
+  }
+#else
+  // Elsewhere, measure at every start-up (or keep the result of get_vco_range in your
+  // board's own non-volatile storage and pass it back with set_vco_range)
+  DDS.characterise_vco();
+#endif
+  DDS.set_freq_Hz((uint32_t)120000000);
+  delay(1000);
+  DDS.set_freq_Hz((uint32_t)98000000);
+}
+
+
+void loop() {
+  
+  
+}
@@ -22,16 +22,20 @@
 //
 
 //=====================
-// Minimal library containing only one public function; to set the frequency of the Si5351
+// Minimal library to set the frequency of the Si5351, plus an optional polar-modulation engine
+// (polar_begin / polar_sample) that drives amplitude and frequency of CLK0 sample by sample
 //
 // Code is minimised by accepting the following limitations
 //  - CLK0 only
-//  - No checks for output frequencies above 150MHz or below 100MHz
+//  - Output Multisynth is an even integer from /4 to /250 and the R divider is not used,
+//    so output frequencies are clamped to 2.4 MHz up to the Si5351's 200 MHz maximum
 //  - Limited testing, and only between 128.7 and 146.7 MHz
 //  - Correction factor, Crystal frequency, Crystal load capacitance 
 //    for your specific Si5351 unit, and output level are all hard coded below (no functions to set them)
-//  - Calculation and register setting is done in one single function (no registers are pre-set for speed)
-//  - The Si5351 is assumed to be initialised (no waiting -> no need for an IC2 read function)
+//  - set_freq_Hz does the full programming procedure only on the first call and when the output
+//    divider changes; otherwise it just updates the Feedback Multisynth on the fly
+//  - The Si5351 is assumed to be initialised (no waiting -> I2C reads are only used by the VCO self-test)
+//  - The VCO is kept within 600-900 MHz unless characterise_vco / set_vco_range widen it for this chip
 //
 //  References cited in G1OJS_Tiny_Si5351_CLK0.cpp:
 //   AN619 application note at https://www.skyworksinc.com/-/media/Skyworks/SL/documents/public/application-notes/AN619.pdf
@@ -45,13 +49,59 @@
 #include <stdint.h>
 #include "Arduino.h"
 #include "Wire.h"
+#if defined(ARDUINO_ARCH_AVR)
+#include "EEPROM.h"
+#endif
 
 #define CorrFact 0.999658117	// Correction factor ( = fout_Hz / freq measured when CorrFact = 1.0)
 #define i2c_bus_address 0x60	// address of Si5351 on the i2c bus
+#define MSNAc  1048575UL 	// MSNA "c": largest allowed value for greatest precision
+#define fout_min_Hz 2401000UL	// lowest output without the R divider (600 MHz / 250, after CorrFact)
+#define fout_max_Hz 200000000UL	// highest output the Si5351 supports (MS0_DIVBY4 above 150 MHz)
+#define vco_eeprom_magic 0xA5	// marks a VCO range stored by store_vco_range as valid
+#define vco_margin_MHz 10	// pulled in from each measured lock limit to allow for temperature drift
 
 
 void G1OJS_Tiny_Si5351_CLK0::set_freq_Hz(uint32_t fout_Hz) { // set frequency fout_Hz (CLK0 only)
 
+  // Choose the Output Multisynth (outdiv, see the paragraph 2 notes under Box 4 below)
+  // ----------------------------------------------
+    // Keep the current outdiv while the VCO stays inside vco_min_MHz to vco_max_MHz (600 to 900 MHz
+    // unless characterise_vco has measured a wider range for this chip) and outdiv = 4 exactly when
+    // fout_Hz is above 150 MHz (only MS0_DIVBY4 mode supports those). Otherwise choose the largest
+    // even outdiv that keeps the VCO at or below the nominal 900 MHz, so a new divider never puts
+    // the VCO near a measured limit or the 600 MHz floor.
+    // Which outdiv a frequency gets can therefore depend on the previous one: after tuning to 140 MHz
+    // (/6), 110 MHz stays on /6 rather than going to /8.
+    // The VCO here is 25 MHz x MSNA, so it includes CorrFact as calc_MSNA does.
+    if (fout_Hz < fout_min_Hz) fout_Hz = fout_min_Hz;
+    if (fout_Hz > fout_max_Hz) fout_Hz = fout_max_Hz;
+    bool divby4 = fout_Hz > 150000000UL;
+    uint32_t fvco_kHz_per_div = fout_Hz * CorrFact / 1000;
+    bool keep_outdiv = configured && ((outdiv == 4) == divby4)
+      && fvco_kHz_per_div * outdiv >= vco_min_MHz * 1000UL && fvco_kHz_per_div * outdiv <= vco_max_MHz * 1000UL;
+    if (!keep_outdiv) {
+      uint32_t div = 900000UL / (fvco_kHz_per_div + 1);		// largest staying at or below 900 MHz
+      div &= ~1UL;							// rounded down to even
+      outdiv = (divby4 || div < 4) ? 4 : (div > 250) ? 250 : div;
+    }
+
+    uint8_t regs[8];
+    calc_MSNA(fout_Hz, regs);
+    MSNAb_per_Hz_Q16 = 0;	// polar_sample is off until polar_begin sets this for the new carrier
+
+  // Same Output Multisynth: the Feedback Multisynth can be changed on the fly (as polar_sample does),
+  // so there is no need for the full Figure 10 procedure and PLL reset
+  // ----------------------------------------------
+    if (keep_outdiv) {
+      write_MSNA_regs(regs, false);
+      if (reg16 != 0x4F) {
+        reg16 = 0x4F;
+        I2CFlexiWrite(16, reg16);
+      }
+      return;
+    }
+
   // Follows data sheet Figure 10. I2C Programming Procedure
 
   // Figure 10 Box 1: Disable Outputs   
@@ -80,49 +130,28 @@ void G1OJS_Tiny_Si5351_CLK0::set_freq_Hz(uint32_t fout_Hz) { // set frequency fo
     // VCO frequency in the range of 600 to 900 MHz using a Feedback Multisynth" 
     // Knowing that our XTAL is 25 MHz, we can know from the first equation of paragraph 3.2 that 
     // the Feedback Multisynth setting a+b/c must be between 600/25 and 900/25, i.e. 24 to 36
-    // The first equation of section 2 likewise constrains Output_Multisynth x R to between 4.09 and 6.99
-    // Given that Output_Multisynth must be 4, 6, 8+b/c (paragraph 2.1.1 note 1), we can only conclude
-    // that Output_Multisynth = 6 (a = 6, b = 0, c= don't care but >=1 and < 2^18) and R = 1
+    // For 100 to 150 MHz, the first equation of section 2 likewise constrains Output_Multisynth x R to
+    // between 4.09 and 6.99. Given that Output_Multisynth must be 4, 6, 8+b/c (paragraph 2.1.1 note 1),
+    // we can only conclude that Output_Multisynth = 6 (a = 6, b = 0, c= don't care but >=1 and < 2^18) and R = 1
+    // Other frequencies get another even integer Output_Multisynth (outdiv, chosen above) the same way
 
     // We can write the Output Multisynth registers and Output Divider setting directly from this conclusion
     // by looking at the register map and noting that (from above):
-    // MS0_P1 = 128 x 6 + 0 - 512 = 256
+    // MS0_P1 = 128 x outdiv + 0 - 512 (= 256 for outdiv = 6)
     // MS0_P2 = 128 x 0 - 1 x 0  = 0
     // MS0_P3 = 1 (the lowest value that "c" can be) or in fact, as b=0, any integer represented in 18 bits
     // R0_DIV = 0 (see description of register 44 on page 34 of AN619)
+    // Divide by 4 is the exception: MS0_P1 = 0 and MS0_DIVBY4 = 11 (register 44 bits 3:2)
 
-    I2CFlexiWrite(42, 0, true, 1,0,1,0,0,0,0);
-
-    // From above and the first equations in section 2, we know that 
-    // fout_Hz = 25000000 x Feedback_Multisynth / 6, i.e. Feedback_Multisynth = fout_Hz * 6/25000000
-    // The Feedback Multisynth setting is (paragraph 3.2) MSNA = a+b/c = fout_Hz * 6/25000000, 
-    // and we need to calculate a, b, c for MS0A, not forgetting that we need to apply the correction factor to fout_Hz first
-    double MSNA = fout_Hz * CorrFact * 6.0 / 25000000.0;
-    uint32_t MSNAa = MSNA;
-    #define MSNAc  1048575UL 	// largest allowed value for greatest precision
-    uint32_t MSNAb = (double)(MSNA - MSNAa) * (double)MSNAc;      
+    uint16_t MS0_P1 = (outdiv == 4) ? 0 : 128 * outdiv - 512;
+    I2CFlexiWrite(42, 0, true, 1, (outdiv == 4) ? 0x0C : 0, MS0_P1 >> 8, MS0_P1 & 0xFF, 0,0,0);
 
-    // Now we can calculate MSNA_P1, MSNA_P2, MSNA_P3 
-    uint32_t MSNA_P1 = 128 * MSNAa + 128 * MSNAb / MSNAc - 512;
-    uint32_t MSNA_P2 = 128 * MSNAb - MSNAc * (128 * MSNAb / MSNAc);
-    uint32_t MSNA_P3 = MSNAc;
-    
-    // write the Feedback Multisynth registers
-    I2CFlexiWrite(26,
-	(uint8_t) ((MSNA_P3>>8) & 0xFF), 		// Reg 26 = MSNA_P3[15:8]
-        true,						// write 7 more registers
-    	(uint8_t) (MSNA_P3 & 0xFF), 			// Reg 27 = MSNA_P3[7:0] 
-    	(uint8_t) ((MSNA_P1>>16) & 0x03), 		// Reg 28 = XXXXXXMSNA_P1[17:16]
-    	(uint8_t) ((MSNA_P1>>8) & 0xFF),		// Reg 29 = MSNA_P1[15:8]  
-    	(uint8_t) (MSNA_P1 & 0xFF),			// Reg 30 = MSNA_P1[7:0] 
-    	(uint8_t) ((MSNA_P3>>12) & 0xF0) 
-               + (uint8_t) ((MSNA_P2>>16) & 0x0F), 	// Reg 31 = MSNA_P3[19:16]MSNA_P2[19:16]
-    	(uint8_t) ((MSNA_P2>>8) & 0xFF),		// Reg 32 = MSNA_P2[15:8]
-    	(uint8_t) (MSNA_P2 & 0xFF)			// Reg 33 = MSNA_P2[7:0]
-        );
+    // write the Feedback Multisynth registers calculated above (see calc_MSNA)
+    write_MSNA_regs(regs, true);
     
-    // CLK0, PLLA, MS0 (Output MS, /6) in integer mode, CLK0 not inverted, MS0 is CLK0 source, 8mA drive
-    I2CFlexiWrite(16, 0x4F);
+    // CLK0, PLLA, MS0 (Output MS, /outdiv) in integer mode, CLK0 not inverted, MS0 is CLK0 source, 8mA drive
+    reg16 = 0x4F;
+    I2CFlexiWrite(16, reg16);
 
     // Figure 10 Box 5: Reset PLLA (we are not using PLLB)
     delayMicroseconds(500);  		// Allow registers to settle before resetting the PLL
@@ -130,9 +159,249 @@ void G1OJS_Tiny_Si5351_CLK0::set_freq_Hz(uint32_t fout_Hz) { // set frequency fo
 
     // Figure 10 Box 6: Enable clock 0 output
     I2CFlexiWrite(3, 0xFE);            	
+    configured = true;
 
   }
 
+// Helper function calc_MSNA sets MSNAa_set, MSNAb_set for fout_Hz with the current outdiv,
+// and fills regs[0..7] with the matching values for registers 26 to 33
+void G1OJS_Tiny_Si5351_CLK0::calc_MSNA(uint32_t fout_Hz, uint8_t *regs) {
+
+    // From the paragraph 2 notes in set_freq_Hz and the first equations in section 2, we know that 
+    // fout_Hz = 25000000 x Feedback_Multisynth / outdiv, i.e. Feedback_Multisynth = fout_Hz * outdiv/25000000
+    // The Feedback Multisynth setting is (paragraph 3.2) MSNA = a+b/c = fout_Hz * outdiv/25000000, 
+    // and we need to calculate a, b, c for MS0A, not forgetting that we need to apply the correction factor to fout_Hz first
+    double MSNA = fout_Hz * CorrFact * outdiv / 25000000.0;
+    MSNAa_set = MSNA;
+    MSNAb_set = (double)(MSNA - MSNAa_set) * (double)MSNAc;      
+    calc_MSNA_regs(MSNAa_set, MSNAb_set, regs);
+}
+
+// Helper function write_MSNA_regs writes registers 26 to 33 from regs[0..7]: all of them, or only
+// the smallest run of consecutive registers that covers every byte changed since the last write
+void G1OJS_Tiny_Si5351_CLK0::write_MSNA_regs(const uint8_t *regs, bool all) {
+
+    uint8_t first = 0, last = 8;
+    if (!all) {
+      while (first < 8 && regs[first] == MSNA_regs[first]) first++;
+      if (first == 8) return;
+      while (regs[last - 1] == MSNA_regs[last - 1]) last--;
+    }
+    I2CBlockWrite(26 + first, regs + first, last - first);
+    for (uint8_t i = first; i < last; i++) MSNA_regs[i] = regs[i];
+}
+
+// Polar modulation engine
+// -----------------------
+// polar_begin sets up the carrier with set_freq_Hz; after that, each polar_sample touches only
+// reg 16 (CLK0 drive strength / power down) and whichever of the Feedback Multisynth registers
+// 28-33 actually change. Small deviations move only MSNA_P2 (regs 31-33); MSNA_P1 (regs 28-30)
+// changes only when 128 x b / c crosses an integer, i.e. about every 32 kHz of output frequency.
+// AN619 paragraph 3.2 allows MSNA to be changed on the fly without a PLL reset, which is what
+// keeps each sample down to at most two short I2C transactions.
+void G1OJS_Tiny_Si5351_CLK0::polar_begin(uint32_t fcarrier_Hz) {
+
+    set_freq_Hz(fcarrier_Hz);
+    // MSNA = fout_Hz * CorrFact * outdiv / 25000000 (see set_freq_Hz), so one Hz moves b by
+    // c * CorrFact * outdiv / 25000000, held here in fixed point to keep the per-sample maths integer
+    MSNAb_per_Hz_Q16 = (double)MSNAc * CorrFact * outdiv / 25000000.0 * 65536.0;
+    // fdev_Hz x MSNAb_per_Hz_Q16 must fit in an int32_t: about +/-130 kHz at /6, +/-97 kHz at /8
+    fdev_max_Hz = 0x7FFFFFFFL / MSNAb_per_Hz_Q16;
+    MSNAb_offset = 0;
+    realised_phase = 0;
+}
+
+void G1OJS_Tiny_Si5351_CLK0::polar_sample(uint8_t amplitude, int32_t fdev_Hz) {
+
+    if (!MSNAb_per_Hz_Q16) return;	// polar_begin has not been called
+
+    // Amplitude: 0 = CLK0 powered down (reg 16 bit 7, CLK0_PDN), otherwise
+    // one of four drive strengths (reg 16 bits 1:0, CLK0_IDRV = 2, 4, 6, 8 mA)
+    uint8_t level = ((uint16_t)amplitude + 63) >> 6;
+    uint8_t new_reg16 = level ? (0x4C | (level - 1)) : 0xCC;
+
+    // Frequency: only when the output is on; while powered down the cached registers
+    // stay as written, so the first sample after power-up writes whatever has changed
+    if (level) {
+      if (fdev_Hz > fdev_max_Hz) fdev_Hz = fdev_max_Hz;
+      if (fdev_Hz < -fdev_max_Hz) fdev_Hz = -fdev_max_Hz;
+      MSNAb_offset = (fdev_Hz * MSNAb_per_Hz_Q16) >> 16;
+      int32_t b = (int32_t)MSNAb_set + MSNAb_offset;
+      uint32_t a = MSNAa_set;
+      while (b < 0) { b += MSNAc; a--; }
+      while (b >= (int32_t)MSNAc) { b -= MSNAc; a++; }
+
+      uint8_t regs[8];
+      calc_MSNA_regs(a, b, regs);
+      write_MSNA_regs(regs, false);
+    }
+
+    if (new_reg16 != reg16) {
+      reg16 = new_reg16;
+      I2CFlexiWrite(16, reg16);
+    }
+}
+
+void G1OJS_Tiny_Si5351_CLK0::polar_sample_phase(uint8_t amplitude, int16_t phase, uint16_t sample_rate_Hz) {
+
+    if (!MSNAb_per_Hz_Q16) return;	// polar_begin has not been called
+
+    // Holding fdev for one sample period advances the phase by fdev / sample_rate cycles, so ask
+    // for the deviation that closes the gap between the target and the phase actually produced.
+    // Clamping and rounding to whole MSNA b steps leave some of the gap, which later samples make up.
+    float err = phase - realised_phase;
+    if (err >= 32768) err -= 65536;
+    if (err < -32768) err += 65536;
+    polar_sample(amplitude, err * sample_rate_Hz / 65536);
+
+    // Phase actually produced (65536 = one cycle): the MSNA b offset now in the chip, which is
+    // MSNAb_offset / (MSNAb_per_Hz_Q16 / 65536) Hz, held for one sample period. While CLK0 is
+    // powered down the PLL keeps running at the last offset written, so this still holds.
+    realised_phase += (float)MSNAb_offset * 65536.0 * 65536.0 / ((float)MSNAb_per_Hz_Q16 * sample_rate_Hz);
+    while (realised_phase >= 32768) realised_phase -= 65536;
+    while (realised_phase < -32768) realised_phase += 65536;
+}
+
+// Bus timing model: each write costs START + address byte + register byte + data bytes + STOP,
+// with every byte taking 9 SCL cycles (8 bits + ACK) and START / STOP about one each.
+// A sample changing amplitude and MSNA_P2 is reg 16 (29 cycles) + regs 31-33 (47 cycles) = 76;
+// a sample that also carries into MSNA_P1 is reg 16 + regs 28-33 (74 cycles) = 103. Hence:
+//    400 kHz: 5263 samples/s (3883 with P1 changes)
+//      1 MHz: 13157 samples/s (9708 with P1 changes) - note the data sheet specifies up to 400 kHz
+// MCU time spent computing each sample and in the Wire library comes on top of this.
+uint32_t G1OJS_Tiny_Si5351_CLK0::polar_max_sample_rate_Hz(uint32_t i2c_clock_Hz, bool P1_changes) {
+    uint8_t cycles_per_sample = (1 + 9 + 9 + 1 * 9 + 1)
+                              + (1 + 9 + 9 + (P1_changes ? 6 : 3) * 9 + 1);
+    return i2c_clock_Hz / cycles_per_sample;
+}
+
+// VCO range self-test
+// -------------------
+// The 600-900 MHz VCO range of AN619 is a guaranteed minimum; most chips lock well beyond it.
+// characterise_vco steps PLLA outwards from each nominal limit, first in 25 MHz steps (one
+// integer step of MSNA) and then in 1 MHz steps, reading LOL_A (reg 0 bit 5) after each PLL reset.
+// The last locking frequency, less vco_margin_MHz, becomes the range set_freq_Hz uses to decide
+// whether it can keep the current Output Multisynth. Read it with get_vco_range to store it, and
+// restore it at start-up with set_vco_range (or store_vco_range / load_vco_range on AVR).
+// The sweep leaves CLK0 disabled and PLLA wherever it stopped, so the next set_freq_Hz does the
+// full Figure 10 procedure and polar_sample does nothing until polar_begin is called again.
+bool G1OJS_Tiny_Si5351_CLK0::characterise_vco() {
+
+    configured = false;
+    MSNAb_per_Hz_Q16 = 0;
+    I2CFlexiWrite(3, 0xFF);    // Disable all CLK output drivers
+    I2CFlexiWrite(15, 0x00);   // XTAL is the PLLA reference (as set_freq_Hz)
+    I2CFlexiWrite(183, 0x2);
+
+    if (!vco_locks(600) || !vco_locks(900)) return false;	// no chip, or it fails at nominal limits
+
+    uint16_t vco_max = find_vco_limit(900, 1);
+    uint16_t vco_min = find_vco_limit(600, -1);
+    vco_max_MHz = (vco_max - vco_margin_MHz > 900) ? vco_max - vco_margin_MHz : 900;
+    vco_min_MHz = (vco_min + vco_margin_MHz < 600) ? vco_min + vco_margin_MHz : 600;
+    return true;
+}
+
+void G1OJS_Tiny_Si5351_CLK0::get_vco_range(uint16_t &vco_min, uint16_t &vco_max) {
+    vco_min = vco_min_MHz;
+    vco_max = vco_max_MHz;
+}
+
+// Sets a VCO range from an earlier characterise_vco; returns false (leaving the range unchanged)
+// if it does not contain 600-900 MHz or lies outside the 375-2250 MHz that MSNA a = 15 to 90
+// allows (paragraph 3.2)
+bool G1OJS_Tiny_Si5351_CLK0::set_vco_range(uint16_t vco_min, uint16_t vco_max) {
+
+    if (vco_min < 375 || vco_min > 600 || vco_max < 900 || vco_max > 2250) return false;
+    vco_min_MHz = vco_min;
+    vco_max_MHz = vco_max;
+    return true;
+}
+
+#if defined(ARDUINO_ARCH_AVR)
+// AVR only: store the VCO range in 5 bytes of EEPROM from eeprom_addr (marker byte, min, max)
+void G1OJS_Tiny_Si5351_CLK0::store_vco_range(int eeprom_addr) {
+
+    EEPROM.update(eeprom_addr, vco_eeprom_magic);
+    EEPROM.put(eeprom_addr + 1, vco_min_MHz);
+    EEPROM.put(eeprom_addr + 3, vco_max_MHz);
+}
+
+// AVR only: restore a range stored by store_vco_range; returns false if none is stored there
+bool G1OJS_Tiny_Si5351_CLK0::load_vco_range(int eeprom_addr) {
+
+    if (EEPROM.read(eeprom_addr) != vco_eeprom_magic) return false;
+    uint16_t vco_min, vco_max;
+    EEPROM.get(eeprom_addr + 1, vco_min);
+    EEPROM.get(eeprom_addr + 3, vco_max);
+    return set_vco_range(vco_min, vco_max);
+}
+#endif
+
+// Helper function find_vco_limit steps from vco_MHz (known to lock) in direction dir (+1 or -1),
+// coarse then fine, and returns the furthest frequency at which PLLA still locks
+uint16_t G1OJS_Tiny_Si5351_CLK0::find_vco_limit(uint16_t vco_MHz, int8_t dir) {
+
+    // MSNA a must lie between 15 and 90 (paragraph 3.2), i.e. 375 to 2250 MHz
+    int16_t step = 25 * dir;	// coarse
+    while (vco_MHz + step >= 375 && vco_MHz + step <= 2250 && vco_locks(vco_MHz + step)) vco_MHz += step;
+    step = dir;			// fine
+    while (vco_MHz + step >= 375 && vco_MHz + step <= 2250 && vco_locks(vco_MHz + step)) vco_MHz += step;
+    return vco_MHz;
+}
+
+// Helper function vco_locks sets PLLA to vco_MHz, resets it and reports whether it has locked
+bool G1OJS_Tiny_Si5351_CLK0::vco_locks(uint16_t vco_MHz) {
+
+    // MSNA = vco_MHz / 25, and MSNAc = 1048575 is exactly 25 x 41943, so b is exact
+    uint8_t regs[8];
+    calc_MSNA_regs(vco_MHz / 25, (vco_MHz % 25) * (MSNAc / 25), regs);
+    I2CBlockWrite(26, regs, 8);
+    delayMicroseconds(500);  		// Allow registers to settle before resetting the PLL
+    I2CFlexiWrite(177, 0x20);  		// Reset the PLL
+    delay(10);				// Allow the PLL time to lock
+    // Register 0 bits are 7:SYS_INIT, 6:LOL_B, 5:LOL_A, 4:LOS_CLKIN, 3:LOS_XTAL
+    return (I2CRead(0) & 0xA0) == 0;
+}
+
+// Helper function calc_MSNA_regs fills regs[0..7] with the values for registers 26 to 33
+// given the Feedback Multisynth MSNA = a + b / MSNAc (AN619 paragraph 3.2)
+void G1OJS_Tiny_Si5351_CLK0::calc_MSNA_regs(uint32_t MSNAa, uint32_t MSNAb, uint8_t *regs) {
+
+    uint32_t MSNA_P1 = 128 * MSNAa + 128 * MSNAb / MSNAc - 512;
+    uint32_t MSNA_P2 = 128 * MSNAb - MSNAc * (128 * MSNAb / MSNAc);
+    uint32_t MSNA_P3 = MSNAc;
+
+    regs[0] = (uint8_t) ((MSNA_P3>>8) & 0xFF); 		// Reg 26 = MSNA_P3[15:8]
+    regs[1] = (uint8_t) (MSNA_P3 & 0xFF); 		// Reg 27 = MSNA_P3[7:0] 
+    regs[2] = (uint8_t) ((MSNA_P1>>16) & 0x03); 	// Reg 28 = XXXXXXMSNA_P1[17:16]
+    regs[3] = (uint8_t) ((MSNA_P1>>8) & 0xFF);		// Reg 29 = MSNA_P1[15:8]  
+    regs[4] = (uint8_t) (MSNA_P1 & 0xFF);		// Reg 30 = MSNA_P1[7:0] 
+    regs[5] = (uint8_t) ((MSNA_P3>>12) & 0xF0) 
+            + (uint8_t) ((MSNA_P2>>16) & 0x0F); 	// Reg 31 = MSNA_P3[19:16]MSNA_P2[19:16]
+    regs[6] = (uint8_t) ((MSNA_P2>>8) & 0xFF);		// Reg 32 = MSNA_P2[15:8]
+    regs[7] = (uint8_t) (MSNA_P2 & 0xFF);		// Reg 33 = MSNA_P2[7:0]
+}
+
+// Helper function I2CBlockWrite writes n bytes to sequential registers starting at reg
+void G1OJS_Tiny_Si5351_CLK0::I2CBlockWrite(uint8_t reg, const uint8_t *data, uint8_t n)
+  {
+    Wire.beginTransmission(i2c_bus_address);
+    Wire.write(reg);
+    for (uint8_t i = 0; i < n; i++) Wire.write(data[i]);
+    Wire.endTransmission();
+}
+
+// Helper function I2CRead reads one byte from the specified register
+uint8_t G1OJS_Tiny_Si5351_CLK0::I2CRead(uint8_t reg)
+  {
+    Wire.beginTransmission(i2c_bus_address);
+    Wire.write(reg);
+    Wire.endTransmission();
+    Wire.requestFrom((uint8_t)i2c_bus_address, (uint8_t)1);
+    return Wire.read();
+}
+
 // Helper function I2CFlexiWrite writes one byte to the specified register,
 // and optionally a further seven bytes to the following sequential registers
 void G1OJS_Tiny_Si5351_CLK0::I2CFlexiWrite(uint8_t reg, uint8_t b0, 
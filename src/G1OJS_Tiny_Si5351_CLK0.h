@@ -22,16 +22,20 @@
 //
 
 //=====================
-// Minimal library containing only one public function; to set the frequency of the Si5351
+// Minimal library to set the frequency of the Si5351, plus an optional polar-modulation engine
+// (polar_begin / polar_sample) that drives amplitude and frequency of CLK0 sample by sample
 //
 // Code is minimised by accepting the following limitations
 //  - CLK0 only
-//  - No checks for output frequencies above 150MHz or below 100MHz
+//  - Output Multisynth is an even integer from /4 to /250 and the R divider is not used,
+//    so output frequencies are clamped to 2.4 MHz up to the Si5351's 200 MHz maximum
 //  - Limited testing, and only between 128.7 and 146.7 MHz
 //  - Correction factor, Crystal frequency, Crystal load capacitance 
 //    for your specific Si5351 unit, and output level are all hard coded below (no functions to set them)
-//  - Calculation and register setting is done in one single function (no registers are pre-set for speed)
-//  - The Si5351 is assumed to be initialised (no waiting -> no need for an IC2 read function)
+//  - set_freq_Hz does the full programming procedure only on the first call and when the output
+//    divider changes; otherwise it just updates the Feedback Multisynth on the fly
+//  - The Si5351 is assumed to be initialised (no waiting -> I2C reads are only used by the VCO self-test)
+//  - The VCO is kept within 600-900 MHz unless characterise_vco / set_vco_range widen it for this chip
 //
 //  References cited in G1OJS_Tiny_Si5351_CLK0.cpp:
 //   AN619 application note at https://www.skyworksinc.com/-/media/Skyworks/SL/documents/public/application-notes/AN619.pdf
@@ -46,17 +50,62 @@
 #include "Arduino.h"
 #include "Wire.h"
 
-#define G1OJS_SI5351_CLK0_VERSION "1.0.1"
+#define G1OJS_SI5351_CLK0_VERSION "1.2.0"
 
 
 class G1OJS_Tiny_Si5351_CLK0{
   public:
 	void set_freq_Hz(uint32_t fout_Hz);
+
+	// Polar modulation: call polar_begin once, then one polar_sample per sample period
+	// (polar_sample does nothing before polar_begin, or after a set_freq_Hz call).
+	// amplitude 0 powers CLK0 down, 1-255 map onto the 2/4/6/8 mA drive strengths;
+	// fdev_Hz is the offset from the carrier, clamped to +/-polar_max_dev_Hz() (set by
+	// polar_begin from the output divider: about 130 kHz at /6, 97 kHz at /8).
+	// polar_sample_phase takes phase instead (65536 = one cycle) and asks for the frequency
+	// offset that moves the phase actually produced so far onto it over one sample period.
+	void polar_begin(uint32_t fcarrier_Hz);
+	void polar_sample(uint8_t amplitude, int32_t fdev_Hz);
+	void polar_sample_phase(uint8_t amplitude, int16_t phase, uint16_t sample_rate_Hz);
+	static uint32_t polar_max_sample_rate_Hz(uint32_t i2c_clock_Hz, bool P1_changes = false);
+	int32_t polar_max_dev_Hz() { return fdev_max_Hz; }
+
+	// VCO range self-test: characterise_vco measures where this chip's PLLA still locks and
+	// uses that range in set_freq_Hz (returns false if the test fails). It leaves CLK0 off:
+	// call set_freq_Hz afterwards, and polar_begin again before any more polar_sample calls.
+	// get_vco_range / set_vco_range let the sketch keep the range wherever it likes;
+	// on AVR, store_vco_range / load_vco_range keep it in 5 bytes of EEPROM at eeprom_addr.
+	bool characterise_vco();
+	void get_vco_range(uint16_t &vco_min, uint16_t &vco_max);
+	bool set_vco_range(uint16_t vco_min, uint16_t vco_max);
+#if defined(ARDUINO_ARCH_AVR)
+	void store_vco_range(int eeprom_addr);
+	bool load_vco_range(int eeprom_addr);
+#endif
   private:
         void I2CFlexiWrite(uint8_t reg, uint8_t b0, 
             bool include_b1_to_b7 = false, 
             uint8_t b1 = 0, uint8_t b2 = 0, uint8_t b3 = 0,
             uint8_t b4 = 0, uint8_t b5 = 0, uint8_t b6 = 0, uint8_t b7 = 0);
+        void I2CBlockWrite(uint8_t reg, const uint8_t *data, uint8_t n);
+        uint8_t I2CRead(uint8_t reg);
+        void calc_MSNA(uint32_t fout_Hz, uint8_t *regs);
+        void calc_MSNA_regs(uint32_t MSNAa, uint32_t MSNAb, uint8_t *regs);
+        void write_MSNA_regs(const uint8_t *regs, bool all);
+        bool vco_locks(uint16_t vco_MHz);
+        uint16_t find_vco_limit(uint16_t vco_MHz, int8_t dir);
+
+        uint16_t vco_min_MHz = 600, vco_max_MHz = 900;	// VCO range used by set_freq_Hz
+        uint8_t outdiv = 6;				// Output Multisynth (even integer) as last set
+        bool configured = false;			// full Figure 10 procedure done, outdiv is in the chip
+
+        uint32_t MSNAa_set = 0, MSNAb_set = 0;	// Feedback Multisynth a, b as set by set_freq_Hz
+        uint8_t MSNA_regs[8] = {0};		// Regs 26-33 as last written
+        uint8_t reg16 = 0x80;			// CLK0 control register as last written
+        int32_t MSNAb_per_Hz_Q16 = 0;		// Change in MSNA b per Hz of output frequency (x 65536), 0 until polar_begin
+        int32_t fdev_max_Hz = 0;		// polar_sample deviation limit, set by polar_begin
+        int32_t MSNAb_offset = 0;		// MSNA b offset from MSNAb_set as last written by polar_sample
+        float realised_phase = 0;		// CLK0 phase produced so far by polar_sample_phase (65536 = one cycle)
 };
 
 #endif